@@ -0,0 +1,252 @@
+/*
+  ==============================================================================
+
+    Number format helpers for the delay line, selected by sample type, and
+    the ping-pong delay line itself built on top of them.
+
+    DelayLineMath<float> is the regular floating point path.
+    DelayLineMath<juce::int16> stores samples as Q15 (full scale is [-1, 1))
+    and does the per-sample interpolation, feedback and read head math in
+    integers, for targets without a fast FPU.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+template <typename SampleType>
+struct DelayLineMath;
+
+//==============================================================================
+template <>
+struct DelayLineMath<float>
+{
+    typedef float Gain;
+    typedef float Position; // delay line position in samples
+    typedef float Phase;    // fractional part of a Position
+
+    static float toSample(float sample)              { return sample; }
+    static float fromSample(float sample)            { return sample; }
+    static Gain toGain(float gain)                   { return gain; }
+    static Position toPosition(double samples)       { return (Position) samples; }
+
+    static float add(float a, float b)               { return a + b; }
+    static float scale(float sample, Gain gain)      { return sample * gain; }
+
+    static float lin_interp(float sample_x, float sample_x1, Phase inPhase)
+    {
+        return (1 - inPhase) * sample_x + inPhase * sample_x1;
+    }
+
+    static Position smooth(Position current, Position target)
+    {
+        return current - 0.001f * (current - target);
+    }
+
+    static Position getReadHead(int writeHead, Position delay, int length)
+    {
+        Position readHead = writeHead - delay;
+
+        if (readHead < 0) {
+            readHead += length;
+        }
+
+        return readHead;
+    }
+
+    static int getIndex(Position readHead)           { return (int) readHead; }
+    static Phase getPhase(Position readHead)         { return readHead - (int) readHead; }
+};
+
+//==============================================================================
+template <>
+struct DelayLineMath<juce::int16>
+{
+    typedef juce::int32 Gain;     // Q15
+    typedef juce::int64 Position; // samples in Q15, 64 bits so long delays at high rates still fit
+    typedef juce::int32 Phase;    // Q15
+
+    static juce::int16 toSample(float sample)
+    {
+        // NaN fails both comparisons in jlimit and can't be cast, so keep it out of the loop
+        if (sample != sample) {
+            return 0;
+        }
+
+        return (juce::int16) juce::jlimit(-32768.0f, 32767.0f, sample * 32768.0f);
+    }
+
+    static float fromSample(juce::int16 sample)
+    {
+        return sample * (1.0f / 32768.0f);
+    }
+
+    // Only call these once per block, they use float math
+    static Gain toGain(float gain)
+    {
+        return juce::jlimit(-32768, 32767, juce::roundToInt(gain * 32768.0f));
+    }
+
+    static Position toPosition(double samples)
+    {
+        return (Position) (samples * 32768.0);
+    }
+
+    static juce::int16 add(juce::int16 a, juce::int16 b)
+    {
+        return (juce::int16) juce::jlimit(-32768, 32767, (juce::int32) a + (juce::int32) b);
+    }
+
+    static juce::int16 scale(juce::int16 sample, Gain gain)
+    {
+        juce::int32 scaled = roundShift((juce::int32) sample * gain);
+
+        // Rounding to nearest alone lets small samples keep their value every pass
+        // (e.g. 24 * 0.98 rounds back to 24), so a feedback tail would never reach 0.
+        // Always move at least 1 LSB toward zero to make the tail decay.
+        juce::int32 inputMagnitude = sample >= 0 ? sample : -sample;
+        juce::int32 scaledMagnitude = scaled >= 0 ? scaled : -scaled;
+
+        if (scaledMagnitude != 0 && scaledMagnitude >= inputMagnitude) {
+            scaled += scaled > 0 ? -1 : 1;
+        }
+
+        return (juce::int16) juce::jlimit(-32768, 32767, scaled);
+    }
+
+    static juce::int16 lin_interp(juce::int16 sample_x, juce::int16 sample_x1, Phase inPhase)
+    {
+        // The two weights sum to 32768 so the result stays between the two samples
+        return (juce::int16) roundShift((32768 - inPhase) * (juce::int32) sample_x
+                                        + inPhase * (juce::int32) sample_x1);
+    }
+
+    static Position smooth(Position current, Position target)
+    {
+        // 1/1024 stands in for the 0.001 coefficient of the float path
+        Position difference = current - target;
+        return current - (difference >= 0 ? difference >> 10 : -((-difference) >> 10));
+    }
+
+    static Position getReadHead(int writeHead, Position delay, int length)
+    {
+        Position readHead = ((Position) writeHead << 15) - delay;
+
+        if (readHead < 0) {
+            readHead += (Position) length << 15;
+        }
+
+        return readHead;
+    }
+
+    static int getIndex(Position readHead)           { return (int) (readHead >> 15); }
+    static Phase getPhase(Position readHead)         { return (Phase) (readHead & 0x7fff); }
+
+private:
+    // Q15 product back to Q0, rounded to nearest and symmetric around zero
+    // (a plain >> 15 floors, which biases negative samples away from zero)
+    static juce::int32 roundShift(juce::int32 value)
+    {
+        return value >= 0 ? (value + (1 << 14)) >> 15 : -((-value + (1 << 14)) >> 15);
+    }
+};
+
+//==============================================================================
+/**
+    Stereo ping-pong delay line, one sample frame at a time.
+
+    Both channels are written first, then each channel reads back from the
+    other one's buffer, so the echoes bounce from left to right.
+*/
+template <typename SampleType>
+class DelayLine
+{
+public:
+    typedef DelayLineMath<SampleType> Math;
+
+    DelayLine() {}
+
+    ~DelayLine()
+    {
+        delete [] mCircularBufferL;
+        delete [] mCircularBufferR;
+    }
+
+    void prepare(int length, typename Math::Position delayTimeInSamples)
+    {
+        if (length != mCircularBufferLength) {
+            delete [] mCircularBufferL;
+            delete [] mCircularBufferR;
+
+            mCircularBufferL = new SampleType[length];
+            mCircularBufferR = new SampleType[length];
+            mCircularBufferLength = length;
+        }
+
+        for (int i = 0; i < length; i++) {
+            mCircularBufferL[i] = SampleType();
+            mCircularBufferR[i] = SampleType();
+        }
+
+        mCircularBufferWriteHead = 0;
+        mDelayTimeInSamples = delayTimeInSamples;
+        mDelayReadHead = 0;
+
+        mFeedbackLeft = SampleType();
+        mFeedbackRight = SampleType();
+    }
+
+    // delayTimeTarget and feedbackGain should be converted once per block with
+    // Math::toPosition and Math::toGain
+    void processSample(float inputLeft, float inputRight,
+                       typename Math::Position delayTimeTarget, typename Math::Gain feedbackGain,
+                       float& delayLeft, float& delayRight)
+    {
+        mDelayTimeInSamples = Math::smooth(mDelayTimeInSamples, delayTimeTarget);
+
+        mCircularBufferL[mCircularBufferWriteHead] = Math::add(Math::toSample(inputLeft), mFeedbackLeft);
+        mCircularBufferR[mCircularBufferWriteHead] = Math::add(Math::toSample(inputRight), mFeedbackRight);
+
+        mDelayReadHead = Math::getReadHead(mCircularBufferWriteHead, mDelayTimeInSamples, mCircularBufferLength);
+
+        int readHead_x = Math::getIndex(mDelayReadHead);
+        typename Math::Phase readHeadPhase = Math::getPhase(mDelayReadHead);
+
+        int readHead_x1 = readHead_x + 1;
+        if (readHead_x1 >= mCircularBufferLength) {
+            readHead_x1 -= mCircularBufferLength;
+        }
+
+        SampleType delay_sample_left = Math::lin_interp(mCircularBufferR[readHead_x], mCircularBufferR[readHead_x1], readHeadPhase);
+        SampleType delay_sample_right = Math::lin_interp(mCircularBufferL[readHead_x], mCircularBufferL[readHead_x1], readHeadPhase);
+
+        mFeedbackLeft = Math::scale(delay_sample_left, feedbackGain);
+        mFeedbackRight = Math::scale(delay_sample_right, feedbackGain);
+
+        delayLeft = Math::fromSample(delay_sample_left);
+        delayRight = Math::fromSample(delay_sample_right);
+
+        mCircularBufferWriteHead++;
+
+        if (mCircularBufferWriteHead >= mCircularBufferLength) {
+            mCircularBufferWriteHead = 0; // fold back to 0 if our position is bigger than buffer length
+        }
+    }
+
+private:
+    SampleType* mCircularBufferL = nullptr;
+    SampleType* mCircularBufferR = nullptr;
+
+    int mCircularBufferWriteHead = 0;
+    int mCircularBufferLength = 0;
+
+    typename Math::Position mDelayTimeInSamples = 0;
+    typename Math::Position mDelayReadHead = 0;
+
+    SampleType mFeedbackLeft = SampleType();
+    SampleType mFeedbackRight = SampleType();
+
+    JUCE_DECLARE_NON_COPYABLE (DelayLine)
+};
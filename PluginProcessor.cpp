@@ -40,28 +40,11 @@ PingpongDelayAudioProcessor::PingpongDelayAudioProcessor()
                                                                    0.01,
                                                                    MAX_DELAY_TIME,
                                                                    0.5));
-    
-    mCircularBufferL = nullptr;
-    mCircularBufferR = nullptr;
-    
-    mCircularBufferWriteHead = 0;
-    mCircularBufferLength = 0;
-    
-    mDelayTimeInSamples = 0;
-    mDelayReadHead = 0;
 
 }
 
 PingpongDelayAudioProcessor::~PingpongDelayAudioProcessor()
 {
-    if (mCircularBufferL != nullptr){
-            delete [] mCircularBufferL;
-            mCircularBufferL = nullptr;
-        }
-    if (mCircularBufferR != nullptr){
-            delete [] mCircularBufferR;
-            mCircularBufferR = nullptr;
-        }
 }
 
 //==============================================================================
@@ -132,29 +115,8 @@ void PingpongDelayAudioProcessor::prepareToPlay (double sampleRate, int samplesP
     // Use this method as the place to do any pre-playback
     // initialisation that you need..
     
-    mCircularBufferLength = sampleRate * MAX_DELAY_TIME;
-
-    mDelayTimeInSamples = sampleRate * *mDelayTimeParameter;
-    
-    mDelayReadHead = 0;
-    
-    if (mCircularBufferL == nullptr) {
-            mCircularBufferL = new float[(int) (sampleRate * MAX_DELAY_TIME)];
-        }
-    
-    juce::zeromem(mCircularBufferL, mCircularBufferLength * sizeof(float));
-    
-    mCircularBufferWriteHead = 0;
-        
-    mDelayTimeSmooth = *mDelayTimeParameter;
-    
-    if (mCircularBufferR == nullptr) {
-            mCircularBufferR = new float[(int) (sampleRate * MAX_DELAY_TIME)];
-        }
-    
-    juce::zeromem(mCircularBufferL, mCircularBufferLength * sizeof(float));
-    
-    mCircularBufferWriteHead = 0;
+    mDelayLine.prepare((int) (sampleRate * MAX_DELAY_TIME),
+                       DelayMath::toPosition(sampleRate * *mDelayTimeParameter));
 }
 
 void PingpongDelayAudioProcessor::releaseResources()
@@ -209,7 +171,9 @@ void PingpongDelayAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer
     // Alternatively, you can process the samples with the channels
     // interleaved by keeping the same state.
     
-    mDelayTimeInSamples = getSampleRate() * *mDelayTimeParameter;
+    // Convert the parameters once per block so the per-sample math stays in the delay line's format
+    auto delayTimeTarget = DelayMath::toPosition(getSampleRate() * *mDelayTimeParameter);
+    auto feedbackGain = DelayMath::toGain(*mFeedbackParameter);
     
     float* leftChannel = buffer.getWritePointer(0); // Get the data from the main buffer as a pointer
     float* rightChannel = buffer.getWritePointer(1);
@@ -252,78 +216,19 @@ void PingpongDelayAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer
                 }*/
         
         //PingPong
+        float delay_sample_left;
+        float delay_sample_right;
+        
+        mDelayLine.processSample(leftChannel[i], rightChannel[i], delayTimeTarget, feedbackGain, delay_sample_left, delay_sample_right);
+        
         if (i % 2 == 0){
-            mDelayTimeSmooth = mDelayTimeSmooth - 0.001 * (mDelayTimeSmooth - *mDelayTimeParameter);
-            mDelayTimeInSamples = getSampleRate() * mDelayTimeSmooth;
-            
-            mCircularBufferL[mCircularBufferWriteHead] = leftChannel[i] + mFeedbackLeft;
-            mCircularBufferR[mCircularBufferWriteHead] = rightChannel[i] + mFeedbackRight;
-                
-            mDelayReadHead =  mCircularBufferWriteHead - mDelayTimeInSamples;
-            
-            if (mDelayReadHead < 0) {
-                    mDelayReadHead += mCircularBufferLength;
-                    }
-            
-            int readHead_x = (int) mDelayReadHead;
-            float readHeadFloat = mDelayReadHead - readHead_x;
-                    
-            int readHead_x1 = readHead_x + 1;
-            if (readHead_x1 >= mCircularBufferLength){
-                readHead_x1 -= mCircularBufferLength;
-            }
-            
-            float delay_sample_left = lin_interp(mCircularBufferR[readHead_x], mCircularBufferR[readHead_x1], readHeadFloat);
-            float delay_sample_right = lin_interp(mCircularBufferL[readHead_x], mCircularBufferL[readHead_x1], readHeadFloat);
-            
-            mFeedbackLeft = delay_sample_left * *mFeedbackParameter;
-            mFeedbackRight = delay_sample_right * *mFeedbackParameter;
-            
             buffer.addSample(0, i, buffer.getSample(0, i) * *mDryWetParameter + delay_sample_left * (1 - *mDryWetParameter));
             //buffer.addSample(1, i, buffer.getSample(1, i) * *mDryWetParameter + delay_sample_right * (1 - *mDryWetParameter));
-                
-            mCircularBufferWriteHead++;
-                
-            if(mCircularBufferWriteHead >= mCircularBufferLength){
-                    mCircularBufferWriteHead = 0; // fold back to 0 if our position is bigger than buffer length
-                    }
         }
         
         if (i % 2 == 1){
-            mDelayTimeSmooth = mDelayTimeSmooth - 0.001 * (mDelayTimeSmooth - *mDelayTimeParameter);
-            mDelayTimeInSamples = getSampleRate() * mDelayTimeSmooth;
-            
-            mCircularBufferL[mCircularBufferWriteHead] = leftChannel[i] + mFeedbackLeft;
-            mCircularBufferR[mCircularBufferWriteHead] = rightChannel[i] + mFeedbackRight;
-                
-            mDelayReadHead =  mCircularBufferWriteHead - mDelayTimeInSamples;
-            
-            if (mDelayReadHead < 0) {
-                    mDelayReadHead += mCircularBufferLength;
-                    }
-            
-            int readHead_x = (int) mDelayReadHead;
-            float readHeadFloat = mDelayReadHead - readHead_x;
-                    
-            int readHead_x1 = readHead_x + 1;
-            if (readHead_x1 >= mCircularBufferLength){
-                readHead_x1 -= mCircularBufferLength;
-            }
-            
-            float delay_sample_left = lin_interp(mCircularBufferR[readHead_x], mCircularBufferR[readHead_x1], readHeadFloat);
-            float delay_sample_right = lin_interp(mCircularBufferL[readHead_x], mCircularBufferL[readHead_x1], readHeadFloat);
-            
-            mFeedbackLeft = delay_sample_left * *mFeedbackParameter;
-            mFeedbackRight = delay_sample_right * *mFeedbackParameter;
-            
             //buffer.addSample(0, i, buffer.getSample(0, i) * *mDryWetParameter + delay_sample_left * (1 - *mDryWetParameter));
             buffer.addSample(1, i, buffer.getSample(1, i) * *mDryWetParameter + delay_sample_right * (1 - *mDryWetParameter));
-                
-            mCircularBufferWriteHead++; //update the write position
-                
-            if(mCircularBufferWriteHead >= mCircularBufferLength){
-                    mCircularBufferWriteHead = 0; // fold back to 0 if our position is bigger than buffer length
-                    }
         }
         
         }
@@ -361,8 +266,3 @@ juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 {
     return new PingpongDelayAudioProcessor();
 }
-
-float PingpongDelayAudioProcessor::lin_interp(float sample_x, float sample_x1, float inPhase)
-{
-    return (1 - inPhase) * sample_x + inPhase * sample_x1;
-}
@@ -10,7 +10,14 @@
 
 #define MAX_DELAY_TIME 2
 
+// Set to 1 to store the delay lines as Q15 fixed point (for targets without a fast FPU).
+// This also halves the memory used by the circular buffers.
+#ifndef PINGPONG_FIXED_POINT
+ #define PINGPONG_FIXED_POINT 0
+#endif
+
 #include <JuceHeader.h>
+#include "DelayLineMath.h"
 
 //==============================================================================
 /**
@@ -55,12 +62,18 @@ public:
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
     
-    float lin_interp(float sample_x, float sample_x1, float inPhase);
-
 private:
     
+   #if PINGPONG_FIXED_POINT
+    using DelaySample = juce::int16; // Q15
+   #else
+    using DelaySample = float;
+   #endif
+    using DelayMath = DelayLineMath<DelaySample>;
+    
+    DelayLine<DelaySample> mDelayLine;
+    
     float mDelaytimeSamples;
-    float mDelayTimeSmooth;
     
     juce::AudioParameterFloat* mDryWetParameter;
     juce::AudioParameterFloat* mFeedbackParameter;
@@ -68,18 +81,6 @@ private:
     
     float mDryWet;
     
-    float mFeedbackLeft;
-    float mFeedbackRight;
-    
-    float* mCircularBufferL;
-    float* mCircularBufferR;
-    
-    int mCircularBufferWriteHead;
-    int mCircularBufferLength;
-    
-    float mDelayTimeInSamples; //self explanatory
-    float mDelayReadHead; //Notice that these are floats, there is a reason for that which will be clear in a few more steps
-    
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PingpongDelayAudioProcessor)
 };
@@ -0,0 +1,188 @@
+/*
+  ==============================================================================
+
+    Compares the Q15 delay line against the float path.
+
+    Build and run from the repository root:
+        c++ -std=c++17 -I Tests Tests/FixedPointAccuracy.cpp -o FixedPointAccuracy
+        ./FixedPointAccuracy
+
+    Each case feeds a sine burst into the left input of the same DelayLine
+    that processBlock uses, so the echoes ping-pong between the channels,
+    then lets it ring out. It reports the max error and SNR of the Q15
+    output against float, and checks that the Q15 feedback tail decays all
+    the way to 0. Returns non-zero if a tail gets stuck or the max error
+    goes above -60 dBFS. The SNR is only reported, as at high feedback it
+    mostly measures the long low level tail.
+
+    The saturation cases drive input plus feedback past full scale. They are
+    compared against a float reference that clips at the same range as Q15,
+    and check that the Q15 output pins at 32767 / -32768 without flipping
+    sign.
+
+  ==============================================================================
+*/
+
+#include "../DelayLineMath.h"
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+//==============================================================================
+// Float samples clipped to the Q15 range, the reference for the saturation cases
+struct ClippedFloat
+{
+    float value = 0.0f;
+};
+
+template <>
+struct DelayLineMath<ClippedFloat>
+{
+    typedef DelayLineMath<float> Float;
+    typedef Float::Gain Gain;
+    typedef Float::Position Position;
+    typedef Float::Phase Phase;
+
+    static ClippedFloat clip(float sample)
+    {
+        return { juce::jlimit(-1.0f, 32767.0f / 32768.0f, sample) };
+    }
+
+    static ClippedFloat toSample(float sample)                 { return clip(sample); }
+    static float fromSample(ClippedFloat sample)               { return sample.value; }
+    static Gain toGain(float gain)                             { return Float::toGain(gain); }
+    static Position toPosition(double samples)                 { return Float::toPosition(samples); }
+
+    static ClippedFloat add(ClippedFloat a, ClippedFloat b)    { return clip(a.value + b.value); }
+    static ClippedFloat scale(ClippedFloat sample, Gain gain)  { return clip(sample.value * gain); }
+
+    static ClippedFloat lin_interp(ClippedFloat sample_x, ClippedFloat sample_x1, Phase inPhase)
+    {
+        return { Float::lin_interp(sample_x.value, sample_x1.value, inPhase) };
+    }
+
+    static Position smooth(Position current, Position target)  { return Float::smooth(current, target); }
+    static Position getReadHead(int writeHead, Position delay, int length) { return Float::getReadHead(writeHead, delay, length); }
+    static int getIndex(Position readHead)                     { return Float::getIndex(readHead); }
+    static Phase getPhase(Position readHead)                   { return Float::getPhase(readHead); }
+};
+
+//==============================================================================
+static const int delayLineLength = 4096;
+
+// Runs the input through the left channel and returns both delayed outputs, interleaved
+template <typename SampleType>
+std::vector<float> runDelayLine(const std::vector<float>& input, double delayInSamples, float feedback)
+{
+    typedef DelayLineMath<SampleType> Math;
+
+    DelayLine<SampleType> delayLine;
+    delayLine.prepare(delayLineLength, Math::toPosition(delayInSamples));
+
+    auto delayTimeTarget = Math::toPosition(delayInSamples);
+    auto feedbackGain = Math::toGain(feedback);
+
+    std::vector<float> output;
+
+    for (float sample : input) {
+        float delayLeft, delayRight;
+        delayLine.processSample(sample, 0.0f, delayTimeTarget, feedbackGain, delayLeft, delayRight);
+
+        output.push_back(delayLeft);
+        output.push_back(delayRight);
+    }
+
+    return output;
+}
+
+static bool runCase(double delayInSamples, float feedback, float amplitude, int burstLength, bool saturates)
+{
+    const int totalLength = 2000000;
+
+    std::vector<float> input((size_t) totalLength, 0.0f);
+    for (int i = 0; i < burstLength; i++) {
+        input[(size_t) i] = amplitude * (float) std::sin(2.0 * M_PI * 441.0 * i / 44100.0);
+    }
+
+    auto reference = saturates ? runDelayLine<ClippedFloat>(input, delayInSamples, feedback)
+                               : runDelayLine<float>(input, delayInSamples, feedback);
+    auto fixedPoint = runDelayLine<juce::int16>(input, delayInSamples, feedback);
+
+    double signalPower = 0, errorPower = 0, maxError = 0;
+    bool reachedPositiveFullScale = false, reachedNegativeFullScale = false, flippedSign = false;
+
+    for (size_t i = 0; i < reference.size(); i++) {
+        double error = (double) fixedPoint[i] - reference[i];
+        signalPower += (double) reference[i] * reference[i];
+        errorPower += error * error;
+        maxError = std::fmax(maxError, std::fabs(error));
+
+        float fixedPointQ15 = fixedPoint[i] * 32768.0f;
+        reachedPositiveFullScale |= fixedPointQ15 == 32767.0f;
+        reachedNegativeFullScale |= fixedPointQ15 == -32768.0f;
+
+        // Wraparound would show up as the opposite sign where the reference is loud
+        if (std::fabs(reference[i]) > 0.5f && (fixedPoint[i] > 0) != (reference[i] > 0)) {
+            flippedSign = true;
+        }
+    }
+
+    double snr = 10.0 * std::log10(signalPower / std::fmax(errorPower, 1e-30));
+
+    // Once the tail has died away in the float path the Q15 path must be silent too
+    bool tailIsSilent = true;
+    for (size_t i = reference.size() - 2 * (size_t) delayLineLength; i < reference.size(); i++) {
+        if (fixedPoint[i] != 0.0f) {
+            tailIsSilent = false;
+        }
+    }
+
+    std::printf("delay %8.2f  feedback %.2f  amplitude %.2f :  max error %.2e (%6.1f dBFS)  SNR %5.1f dB  tail %s",
+                delayInSamples, feedback, amplitude, maxError, 20.0 * std::log10(std::fmax(maxError, 1e-30)),
+                snr, tailIsSilent ? "decays to 0" : "STUCK");
+
+    bool passed = tailIsSilent && maxError < 1.0e-3;
+
+    if (saturates) {
+        bool pinned = reachedPositiveFullScale && reachedNegativeFullScale;
+        std::printf("  clipping %s%s", pinned ? "pinned at full scale" : "NOT REACHED", flippedSign ? ", SIGN FLIP" : "");
+        passed = passed && pinned && ! flippedSign;
+    }
+
+    std::printf("\n");
+    return passed;
+}
+
+static bool checkNonFiniteInput()
+{
+    typedef DelayLineMath<juce::int16> Math;
+
+    bool passed = Math::toSample(std::nanf("")) == 0
+               && Math::toSample(INFINITY) == 32767
+               && Math::toSample(-INFINITY) == -32768;
+
+    std::printf("non-finite input :  NaN -> %d, +inf -> %d, -inf -> %d\n",
+                Math::toSample(std::nanf("")), Math::toSample(INFINITY), Math::toSample(-INFINITY));
+
+    return passed;
+}
+
+int main()
+{
+    bool passed = true;
+
+    passed &= runCase(1000.0, 0.5f, 0.5f, 8000, false);
+    passed &= runCase(1000.37, 0.5f, 0.5f, 8000, false);
+    passed &= runCase(2047.5, 0.98f, 0.5f, 8000, false);
+    passed &= runCase(333.25, 0.98f, 0.01f, 8000, false);
+
+    // Whole periods of the 441 Hz sine, so the echoes add up in phase
+    passed &= runCase(1000.0, 0.98f, 0.9f, 40000, true);
+    passed &= runCase(1000.0, 0.5f, 1.5f, 8000, true);
+
+    passed &= checkNonFiniteInput();
+
+    std::printf(passed ? "PASSED\n" : "FAILED\n");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,36 @@
+/*
+  ==============================================================================
+
+    Minimal stand-in for the JUCE header, just enough for DelayLineMath.h
+    so the accuracy check can be built without the JUCE modules.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+#define JUCE_DECLARE_NON_COPYABLE(className) \
+    className (const className&) = delete; \
+    className& operator= (const className&) = delete;
+
+namespace juce
+{
+    typedef int16_t int16;
+    typedef int32_t int32;
+    typedef int64_t int64;
+
+    template <typename Type>
+    Type jlimit(Type lowerLimit, Type upperLimit, Type valueToConstrain)
+    {
+        return valueToConstrain < lowerLimit ? lowerLimit
+             : (upperLimit < valueToConstrain ? upperLimit : valueToConstrain);
+    }
+
+    inline int roundToInt(float value)
+    {
+        return (int) std::lround(value);
+    }
+}